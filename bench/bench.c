@@ -0,0 +1,318 @@
+#include <kh-astgen/lexer.h>
+#include <kh-astgen/ast.h>
+#include "corpus.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/*
+ *  kh_astgen_bench
+ *  Measures lexer and AST construction throughput over generated corpora.
+ *
+ *  usage: kh_astgen_bench [--size <bytes>] [--reps <count>] [--seed <value>] [--corpus <name|all>] [--json]
+ */
+
+typedef struct _bench_options {
+  kh_sz   size;
+  kh_u32  reps;
+  kh_u64  seed;
+  int     corpus; // -1 for all
+  kh_bool json;
+} bench_options;
+
+typedef struct _bench_stat {
+  kh_u64 median_ns;
+  kh_u64 p99_ns;
+} bench_stat;
+
+typedef struct _bench_result {
+  kh_bench_corpus_kind kind;
+  kh_sz                bytes;
+  kh_sz                tokens;
+  kh_sz                nodes;
+  bench_stat           lexer;
+  bench_stat           ast;
+} bench_result;
+
+// ----------------------------------------------------------------------------------------------------
+
+static kh_u64 now_ns() {
+  struct timespec ts;
+  timespec_get(&ts, TIME_UTC);
+  return (kh_u64)ts.tv_sec * 1000000000ull + (kh_u64)ts.tv_nsec;
+}
+
+static int cmp_u64(const void * a, const void * b) {
+  const kh_u64 x = *(const kh_u64 *)a;
+  const kh_u64 y = *(const kh_u64 *)b;
+  return (x > y) - (x < y);
+}
+
+// Sorts `samples` in place
+static bench_stat summarize(kh_u64 * samples, kh_u32 count) {
+  qsort(samples, count, sizeof(samples[0]), cmp_u64);
+
+  // [18/10/2026] Nearest rank p99, with few repetitions this is simply the slowest run
+  kh_u32 p99 = (count * 99 + 99) / 100;
+  bench_stat stat = {
+    .median_ns = count % 2 ? samples[count / 2] : (samples[count / 2 - 1] + samples[count / 2]) / 2,
+    .p99_ns    = samples[p99 - 1],
+  };
+  return stat;
+}
+
+static double per_second(kh_sz amount, kh_u64 ns) {
+  return ns ? (double)amount * 1e9 / (double)ns : 0.0;
+}
+
+// ----------------------------------------------------------------------------------------------------
+
+static kh_bool run_lexer(kh_lexer_context * ctx, const kh_utf8 * src, kh_sz src_size, kh_lexer_token_entry * tokens, kh_sz tokens_size) {
+  memset(ctx, 0, sizeof(*ctx));
+  ctx->status            = KH_LEXER_STATUS_OK;
+  ctx->token_buffer      = tokens;
+  ctx->token_buffer_size = tokens_size;
+  ctx->src               = src;
+  ctx->src_size          = src_size;
+#if defined(KH_TRACK_LINE_COLUMN)
+  ctx->line   = 1;
+  ctx->column = 1;
+#endif
+
+  // [18/10/2026] The token buffer is sized for the worst case so a buffer exhaust is treated as a failure as well
+  return kh_lexer(ctx) == KH_LEXER_RESPONSE_OK;
+}
+
+/*
+ *  [18/10/2026]
+ *  Builds a tree with a node per token, tokens are chained to the left of their statement
+ *  and every ';' or '{' starts a new statement appended to the right of the previous one.
+ *  There's no parser yet so this only measures the cost of appending and hashing nodes.
+ */
+static kh_bool run_ast(kh_lexer_context * ctx, kh_ast_tree * tree) {
+  if (kh_ast_init_tree(tree) != KH_AST_RESPONSE_OK)
+    return 0;
+
+  kh_ast_node_id statement = 0;
+  kh_ast_node_id last      = 0;
+
+  kh_lexer_token_entry * c = 0;
+  if (kh_lexer_token_entry_first(ctx, &c)) {
+    do {
+      kh_ast_node_id child = 0;
+
+      // [18/10/2026] Child offsets are a kh_u8 so a long statement is split before the next statement would be out of reach,
+      // appending to the left doesn't have this issue as it's always 1
+      const kh_bool new_statement = last - statement >= KH_U8_INVALID - 2 || (
+        kh_lexer_token_entry_type_get(c) == KH_TOK_CHARSYM && (
+          kh_lexer_token_entry_value_charsym_get(c) == ';' ||
+          kh_lexer_token_entry_value_charsym_get(c) == '{'
+        )
+      );
+
+      if (new_statement) {
+        if (kh_ast_append_right(tree, statement, &child) != KH_AST_RESPONSE_OK)
+          return 0;
+        statement = child;
+      } else {
+        if (kh_ast_append_left(tree, last, &child) != KH_AST_RESPONSE_OK)
+          return 0;
+      }
+
+      last = child;
+    } while (kh_lexer_token_entry_next(ctx, &c));
+  }
+
+#if defined(KH_AST_TRACK_HASH)
+  if (kh_ast_tree_hash(tree) != KH_AST_RESPONSE_OK)
+    return 0;
+#endif
+
+  return 1;
+}
+
+static kh_bool run_corpus(const bench_options * opt, kh_bench_corpus_kind kind, bench_result * result) {
+  kh_bool ok = 0;
+
+  // [18/10/2026] Every token consumes at least a byte so this can never exhaust, +1 as acquire_entry never fills the last entry
+  const kh_sz tokens_size = (opt->size + 1) * sizeof(kh_lexer_token_entry);
+  // The root and a node per token
+  const kh_sz nodes_size  = (opt->size + 2) * sizeof(kh_ast_node);
+
+  kh_utf8              * src     = malloc(opt->size);
+  kh_lexer_token_entry * tokens  = malloc(tokens_size);
+  kh_ast_node          * nodes   = malloc(nodes_size);
+  kh_u64               * samples = malloc(opt->reps * sizeof(kh_u64));
+  if (!src || !tokens || !nodes || !samples) {
+    fprintf(stderr, "kh_astgen_bench: out of memory\n");
+    goto cleanup;
+  }
+
+  kh_bench_corpus_generate(kind, opt->seed, src, opt->size);
+
+  kh_lexer_context ctx;
+  kh_ast_tree      tree = { .root = nodes, .sz = nodes_size, .last_node = 0 };
+
+  // [18/10/2026] Warm up caches and page in the buffers before measuring
+  if (!run_lexer(&ctx, src, opt->size, tokens, tokens_size)) {
+    fprintf(stderr, "kh_astgen_bench: lexer failed on corpus '%s' with status %d at offset %zu\n", kh_bench_corpus_name(kind), (int)ctx.status, (size_t)ctx.isrc);
+    goto cleanup;
+  }
+  if (!run_ast(&ctx, &tree)) {
+    fprintf(stderr, "kh_astgen_bench: AST construction failed on corpus '%s'\n", kh_bench_corpus_name(kind));
+    goto cleanup;
+  }
+
+  for (kh_u32 i = 0; i < opt->reps; ++i) {
+    const kh_u64 start = now_ns();
+    run_lexer(&ctx, src, opt->size, tokens, tokens_size);
+    samples[i] = now_ns() - start;
+  }
+  result->lexer = summarize(samples, opt->reps);
+
+  for (kh_u32 i = 0; i < opt->reps; ++i) {
+    const kh_u64 start = now_ns();
+    run_ast(&ctx, &tree);
+    samples[i] = now_ns() - start;
+  }
+  result->ast = summarize(samples, opt->reps);
+
+  result->kind   = kind;
+  result->bytes  = opt->size;
+  result->tokens = ctx.itoken_buffer / kh_lexer_token_entry_size();
+  result->nodes  = tree.last_node + 1;
+  ok = 1;
+
+cleanup:
+  free(samples);
+  free(nodes);
+  free(tokens);
+  free(src);
+  return ok;
+}
+
+// ----------------------------------------------------------------------------------------------------
+
+static void print_text(const bench_options * opt, const bench_result * results, kh_u32 count) {
+  printf("kh_astgen_bench: %zu bytes, %u repetitions, seed %llu\n", (size_t)opt->size, opt->reps, (unsigned long long)opt->seed);
+  printf("%-12s %12s %12s %14s %12s %12s %14s %12s %12s\n", "corpus", "tokens", "lex MB/s", "lex tokens/s", "lex med ms", "lex p99 ms", "ast nodes/s", "ast med ms", "ast p99 ms");
+  for (kh_u32 i = 0; i < count; ++i) {
+    const bench_result * r = &results[i];
+    printf("%-12s %12zu %12.2f %14.0f %12.3f %12.3f %14.0f %12.3f %12.3f\n",
+      kh_bench_corpus_name(r->kind),
+      (size_t)r->tokens,
+      per_second(r->bytes, r->lexer.median_ns) / 1e6,
+      per_second(r->tokens, r->lexer.median_ns),
+      r->lexer.median_ns / 1e6,
+      r->lexer.p99_ns / 1e6,
+      per_second(r->nodes, r->ast.median_ns),
+      r->ast.median_ns / 1e6,
+      r->ast.p99_ns / 1e6
+    );
+  }
+}
+
+static void print_json(const bench_options * opt, const bench_result * results, kh_u32 count) {
+  printf("{\n");
+  printf("  \"bytes\": %zu,\n", (size_t)opt->size);
+  printf("  \"repetitions\": %u,\n", opt->reps);
+  printf("  \"seed\": %llu,\n", (unsigned long long)opt->seed);
+  printf("  \"results\": [\n");
+  for (kh_u32 i = 0; i < count; ++i) {
+    const bench_result * r = &results[i];
+    printf("    {\n");
+    printf("      \"corpus\": \"%s\",\n", kh_bench_corpus_name(r->kind));
+    printf("      \"tokens\": %zu,\n", (size_t)r->tokens);
+    printf("      \"nodes\": %zu,\n", (size_t)r->nodes);
+    printf("      \"lexer\": { \"median_ns\": %llu, \"p99_ns\": %llu, \"mb_per_s\": %.3f, \"tokens_per_s\": %.0f },\n",
+      (unsigned long long)r->lexer.median_ns,
+      (unsigned long long)r->lexer.p99_ns,
+      per_second(r->bytes, r->lexer.median_ns) / 1e6,
+      per_second(r->tokens, r->lexer.median_ns)
+    );
+    printf("      \"ast\": { \"median_ns\": %llu, \"p99_ns\": %llu, \"nodes_per_s\": %.0f }\n",
+      (unsigned long long)r->ast.median_ns,
+      (unsigned long long)r->ast.p99_ns,
+      per_second(r->nodes, r->ast.median_ns)
+    );
+    printf("    }%s\n", i + 1 < count ? "," : "");
+  }
+  printf("  ]\n");
+  printf("}\n");
+}
+
+static int usage(const char * self) {
+  fprintf(stderr, "usage: %s [--size <bytes>] [--reps <count>] [--seed <value>] [--corpus <name|all>] [--json]\n", self);
+  fprintf(stderr, "corpora:");
+  for (int i = 0; i < KH_BENCH_CORPUS_COUNT; ++i)
+    fprintf(stderr, " %s", kh_bench_corpus_name(i));
+  fprintf(stderr, "\n");
+  return 1;
+}
+
+int main(int argc, char ** argv) {
+  bench_options opt = {
+    .size   = 4 * 1024 * 1024,
+    .reps   = 20,
+    .seed   = 0x6B68756E656F,
+    .corpus = -1,
+    .json   = 0,
+  };
+
+  for (int i = 1; i < argc; ++i) {
+    const char * arg   = argv[i];
+    const char * value = i + 1 < argc ? argv[i + 1] : 0;
+
+    if (strcmp(arg, "--json") == 0) {
+      opt.json = 1;
+      continue;
+    }
+
+    if (!value)
+      return usage(argv[0]);
+    ++i;
+
+    if (strcmp(arg, "--size") == 0) {
+      opt.size = strtoull(value, 0, 10);
+    } else if (strcmp(arg, "--reps") == 0) {
+      opt.reps = (kh_u32)strtoul(value, 0, 10);
+    } else if (strcmp(arg, "--seed") == 0) {
+      opt.seed = strtoull(value, 0, 0);
+    } else if (strcmp(arg, "--corpus") == 0) {
+      if (strcmp(value, "all") != 0) {
+        opt.corpus = KH_BENCH_CORPUS_COUNT;
+        for (int k = 0; k < KH_BENCH_CORPUS_COUNT; ++k) {
+          if (strcmp(value, kh_bench_corpus_name(k)) == 0)
+            opt.corpus = k;
+        }
+        if (opt.corpus == KH_BENCH_CORPUS_COUNT)
+          return usage(argv[0]);
+      }
+    } else {
+      return usage(argv[0]);
+    }
+  }
+
+  if (opt.size == 0 || opt.reps == 0)
+    return usage(argv[0]);
+
+  bench_result results[KH_BENCH_CORPUS_COUNT];
+  kh_u32 count = 0;
+
+  for (int k = 0; k < KH_BENCH_CORPUS_COUNT; ++k) {
+    if (opt.corpus != -1 && opt.corpus != k)
+      continue;
+    if (!run_corpus(&opt, k, &results[count]))
+      return 1;
+    ++count;
+  }
+
+  if (opt.json)
+    print_json(&opt, results, count);
+  else
+    print_text(&opt, results, count);
+
+  return 0;
+}
@@ -0,0 +1,160 @@
+#include "corpus.h"
+
+// [18/10/2026] Largest unit any of the generators can emit, the remainder of the buffer is padded with whitespace
+#define MAX_UNIT_SIZE 96
+
+typedef struct _corpus_writer {
+  kh_utf8 * buffer;
+  kh_sz     size;
+  kh_sz     i;
+  kh_u64    rng;
+} corpus_writer;
+
+static const kh_utf8 id_head[]  = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ_$";
+static const kh_utf8 id_tail[]  = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ_$0123456789";
+static const kh_utf8 text[]     = "abcdefghijklmnopqrstuvwxyz ABCDEFGHIJKLMNOPQRSTUVWXYZ 0123456789 .,;:!?";
+static const kh_utf8 hex[]      = "0123456789abcdefABCDEF";
+static const kh_utf8 str_delim[] = { '"', '\'', '`' };
+static const kh_utf8 symbols[]  = ";.+-*/=,:(){}[]<>";
+
+// xorshift64, deterministic across platforms unlike rand()
+static kh_u64 next(corpus_writer * w) {
+  w->rng ^= w->rng << 13;
+  w->rng ^= w->rng >> 7;
+  w->rng ^= w->rng << 17;
+  return w->rng;
+}
+
+static kh_u32 range(corpus_writer * w, kh_u32 min, kh_u32 max) {
+  return min + (kh_u32)(next(w) % (max - min + 1));
+}
+
+static void put(corpus_writer * w, kh_utf8 ch) {
+  w->buffer[w->i++] = ch;
+}
+
+// `set` is a string literal so its size includes the null terminator
+static void put_from(corpus_writer * w, const kh_utf8 * set, kh_sz set_size) {
+  put(w, set[next(w) % (set_size - 1)]);
+}
+
+static void put_separator(corpus_writer * w) {
+  switch (next(w) % 4) {
+    case 0:  put(w, ';'); put(w, '\n'); break;
+    case 1:  put(w, '\n'); break;
+    default: put(w, ' '); break;
+  }
+}
+
+static void gen_identifier(corpus_writer * w) {
+  put_from(w, id_head, sizeof(id_head));
+  for (kh_u32 n = range(w, 0, 15); n; --n)
+    put_from(w, id_tail, sizeof(id_tail));
+  put_separator(w);
+}
+
+static void gen_string(corpus_writer * w) {
+  const kh_utf8 delim = str_delim[next(w) % sizeof(str_delim)];
+  put(w, delim);
+  for (kh_u32 n = range(w, 0, 48); n; --n)
+    put_from(w, text, sizeof(text));
+  put(w, delim);
+  put_separator(w);
+}
+
+static void gen_number(corpus_writer * w) {
+  switch (next(w) % 3) {
+    case 0: // Base 10
+      put(w, (kh_utf8)('1' + next(w) % 9));
+      for (kh_u32 n = range(w, 0, 9); n; --n)
+        put(w, (kh_utf8)('0' + next(w) % 10));
+      break;
+    case 1: // Base 16
+      put(w, '0');
+      put(w, 'x');
+      for (kh_u32 n = range(w, 1, 16); n; --n)
+        put_from(w, hex, sizeof(hex));
+      break;
+    case 2: // Floating
+      for (kh_u32 n = range(w, 1, 6); n; --n)
+        put(w, (kh_utf8)('0' + next(w) % 10));
+      put(w, '.');
+      for (kh_u32 n = range(w, 1, 6); n; --n)
+        put(w, (kh_utf8)('0' + next(w) % 10));
+      break;
+  }
+  put(w, next(w) % 2 ? ',' : ' ');
+  put_separator(w);
+}
+
+static void gen_comment(corpus_writer * w) {
+  const kh_bool single_line = next(w) % 2;
+  put(w, '/');
+  put(w, single_line ? '/' : '*');
+  for (kh_u32 n = range(w, 0, 72); n; --n)
+    put_from(w, text, sizeof(text));
+  if (!single_line) {
+    put(w, '*');
+    put(w, '/');
+  }
+  put(w, '\n');
+}
+
+static void gen_symbol(corpus_writer * w) {
+  put_from(w, symbols, sizeof(symbols));
+  put(w, ' ');
+}
+
+static void gen_mixed(corpus_writer * w) {
+  // [18/10/2026] Weighted to roughly resemble actual code
+  const kh_u32 pick = next(w) % 16;
+  if (pick < 6)
+    gen_identifier(w);
+  else if (pick < 10)
+    gen_symbol(w);
+  else if (pick < 12)
+    gen_number(w);
+  else if (pick < 14)
+    gen_string(w);
+  else
+    gen_comment(w);
+}
+
+typedef void(*gen_cb_t)(corpus_writer *);
+
+static const gen_cb_t generators[] = {
+  gen_identifier,
+  gen_string,
+  gen_number,
+  gen_comment,
+  gen_mixed,
+};
+
+static const char * names[] = {
+  "identifier",
+  "string",
+  "number",
+  "comment",
+  "mixed",
+};
+
+const char * kh_bench_corpus_name(kh_bench_corpus_kind kind) {
+  return names[kind];
+}
+
+void kh_bench_corpus_generate(kh_bench_corpus_kind kind, kh_u64 seed, kh_utf8 * buffer, kh_sz size) {
+  corpus_writer w = {
+    .buffer = buffer,
+    .size   = size,
+    .i      = 0,
+    .rng    = seed ? seed : 1, // xorshift gets stuck on 0
+  };
+
+  while (w.size - w.i > MAX_UNIT_SIZE)
+    generators[kind](&w);
+
+  while (w.i < w.size)
+    put(&w, ' ');
+}
+
+#undef MAX_UNIT_SIZE
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <kh-core/types.h>
+
+typedef enum _kh_bench_corpus_kind {
+  KH_BENCH_CORPUS_IDENTIFIER,
+  KH_BENCH_CORPUS_STRING,
+  KH_BENCH_CORPUS_NUMBER,
+  KH_BENCH_CORPUS_COMMENT,
+  KH_BENCH_CORPUS_MIXED,
+  KH_BENCH_CORPUS_COUNT,
+} kh_bench_corpus_kind;
+
+/*
+ *  Obtains the name of a corpus kind, used for the command line and reports.
+ */
+const char * kh_bench_corpus_name(kh_bench_corpus_kind kind);
+
+/*
+ *  Fills `buffer` with exactly `size` bytes of lexable source dominated by `kind`.
+ *  The output only depends on `kind`, `size` and `seed` so runs can be compared.
+ */
+void kh_bench_corpus_generate(kh_bench_corpus_kind kind, kh_u64 seed, kh_utf8 * buffer, kh_sz size);
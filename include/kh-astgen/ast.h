@@ -4,6 +4,8 @@
 
 typedef kh_u32 kh_ast_node_id;
 
+#define KH_AST_NODE_ID_INVALID ((kh_ast_node_id)-1)
+
 typedef enum _kh_ast_node_type {
   KH_AST_NODE_EMPTY,
   KH_AST_NODE_ROOT,
@@ -19,12 +21,28 @@ typedef enum _kh_ast_response {
    *  occupied this response is returned instead.
    */
   KH_AST_RESPONSE_OCCUPIED,
+
+  /*
+   *  Returned when loading a snapshot whose header or checksum does not validate
+   *  (wrong magic, different astgen version or node layout, truncated or corrupted buffer).
+   */
+  KH_AST_RESPONSE_SNAPSHOT_INVALID,
+
+  /*
+   *  Returned when loading a valid snapshot that was generated from a different
+   *  source. The tree should be rebuilt and a new snapshot saved.
+   */
+  KH_AST_RESPONSE_SNAPSHOT_STALE,
 } kh_ast_response;
 
 typedef struct _kh_ast_node {
   kh_ast_node_type type;
   kh_u8 left;
   kh_u8 right;
+
+#if defined(KH_AST_TRACK_HASH)
+  kh_u64 hash; // Structural hash of the subtree starting at this node (see kh_ast_tree_hash)
+#endif
 } kh_ast_node;
 
 typedef struct _kh_ast_tree {
@@ -34,6 +52,27 @@ typedef struct _kh_ast_tree {
   kh_sz last_node; // Last created node for fast append lookup
 } kh_ast_tree;
 
+/*
+ *  Snapshot format version. Bump this whenever `kh_ast_node` or the snapshot
+ *  layout changes so snapshots from an older astgen are rejected on load.
+ */
+#define KH_AST_SNAPSHOT_VERSION 1
+#define KH_AST_SNAPSHOT_MAGIC   0x5341484B // 'KHAS'
+
+/*
+ *  Header placed at the start of a snapshot buffer, the node buffer follows right after it.
+ *  Nodes only reference each other through offsets so the node buffer is used as is
+ *  (no pointer fixups), which allows a snapshot to be loaded straight from an mmap'd file.
+ */
+typedef struct _kh_ast_snapshot_header {
+  kh_u32 magic;      // KH_AST_SNAPSHOT_MAGIC
+  kh_u32 version;    // KH_AST_SNAPSHOT_VERSION of the astgen that saved it
+  kh_u32 node_size;  // sizeof(kh_ast_node) of the astgen that saved it
+  kh_u32 node_count; // Number of nodes following the header
+  kh_u64 src_hash;   // Hash of the source the tree was generated from (see kh_ast_hash_source)
+  kh_u64 checksum;   // Hash of the node buffer
+} kh_ast_snapshot_header;
+
 /*
  *  Initializes a fresh `kh_ast_tree` by filling the root with the approriate values.
  *  NOTE: This only initializes the `tree` structure. No allocations are made, that's
@@ -45,3 +84,114 @@ kh_ast_response kh_ast_init_tree(kh_ast_tree * tree);
  *  Appends a child node to the left of a parent node
  */
 kh_ast_response kh_ast_append_left(kh_ast_tree * tree, kh_ast_node_id parent, kh_ast_node_id * child_id_out);
+
+/*
+ *  Appends a child node to the right of a parent node
+ */
+kh_ast_response kh_ast_append_right(kh_ast_tree * tree, kh_ast_node_id parent, kh_ast_node_id * child_id_out);
+
+/*
+ *  Hashes a source buffer, used as the key of a snapshot to
+ *  determine whether it is still up to date.
+ */
+kh_u64 kh_ast_hash_source(const kh_utf8 * src, kh_sz src_size);
+
+/*
+ *  Reports the size in bytes required to save a snapshot of `tree`
+ */
+kh_sz kh_ast_snapshot_size(const kh_ast_tree * tree);
+
+/*
+ *  Saves a snapshot of `tree` into `buffer`. `src_hash` should be the result of
+ *  `kh_ast_hash_source` on the source the tree was generated from.
+ *  Returns KH_AST_RESPONSE_BUFFER_EXHAUSTED if `buffer_size` is less than `kh_ast_snapshot_size`.
+ *  NOTE: Writing the buffer somewhere (eg. a file) is left to the caller.
+ */
+kh_ast_response kh_ast_snapshot_save(const kh_ast_tree * tree, kh_u64 src_hash, void * buffer, kh_sz buffer_size);
+
+/*
+ *  Loads a snapshot from `buffer` into `tree` without copying, `tree->root` is pointed
+ *  directly at the nodes inside `buffer` so it must outlive the tree. Only the header
+ *  and the checksum are validated.
+ *  Returns KH_AST_RESPONSE_SNAPSHOT_STALE if the snapshot was not generated from a source
+ *  matching `src_hash` and KH_AST_RESPONSE_SNAPSHOT_INVALID if it fails validation, in both
+ *  cases `tree` is left untouched.
+ *  NOTE: If the buffer is mapped read only (eg. mmap with PROT_READ) the tree must not be
+ *  modified, map it as copy on write (MAP_PRIVATE) if you intend to.
+ */
+kh_ast_response kh_ast_snapshot_load(kh_ast_tree * tree, kh_u64 src_hash, void * buffer, kh_sz buffer_size);
+
+typedef kh_ast_response(*kh_ast_rebuild_cb_t)(kh_ast_tree * tree, void * user);
+
+/*
+ *  Loads a snapshot from `buffer` into `tree`, if the snapshot is stale or invalid
+ *  `rebuild` is called instead to generate `tree` (in which case `tree` should be set up
+ *  with its own buffer beforehand). Returns the response of the load or of `rebuild`.
+ *  It's up to the caller to save a new snapshot after a rebuild.
+ */
+kh_ast_response kh_ast_snapshot_load_or_rebuild(kh_ast_tree * tree, kh_u64 src_hash, void * buffer, kh_sz buffer_size, kh_ast_rebuild_cb_t rebuild, void * user);
+
+/*
+ *  Obtains the structural hash of a node. Returns 0 if
+ *  `KH_AST_TRACK_HASH` is not enabled.
+ */
+kh_u64 kh_ast_node_hash_get(const kh_ast_tree * tree, kh_ast_node_id id);
+
+/*
+ *  Recomputes the structural hash of a single node from its type and its
+ *  children's hashes. Appended nodes already have a hash as a leaf, call this
+ *  on a node once its children are complete to keep hashes up to date as the tree is built.
+ *  Returns KH_AST_RESPONSE_ERR if `KH_AST_TRACK_HASH` is not enabled.
+ */
+kh_ast_response kh_ast_node_hash_update(kh_ast_tree * tree, kh_ast_node_id id);
+
+/*
+ *  Computes the structural hash of every node in a single post order pass.
+ *  Returns KH_AST_RESPONSE_ERR if `KH_AST_TRACK_HASH` is not enabled.
+ */
+kh_ast_response kh_ast_tree_hash(kh_ast_tree * tree);
+
+typedef struct _kh_ast_hash_map_entry {
+  kh_u64         hash;
+  kh_ast_node_id id;
+} kh_ast_hash_map_entry;
+
+/*
+ *  Open addressing map of subtree hash -> node id. `entries` is provided by the
+ *  caller and `capacity` (in entries, not bytes) must be a power of two.
+ */
+typedef struct _kh_ast_hash_map {
+  kh_ast_hash_map_entry * entries;
+  kh_sz                   capacity;
+  kh_sz                   count;
+} kh_ast_hash_map;
+
+/*
+ *  Clears every entry of `map`.
+ *  Returns KH_AST_RESPONSE_ERR if `capacity` is not a power of two.
+ */
+kh_ast_response kh_ast_hash_map_init(kh_ast_hash_map * map);
+
+/*
+ *  Inserts every node of a hashed `tree` into `map`. Identical subtrees are only inserted once.
+ *  Returns KH_AST_RESPONSE_BUFFER_EXHAUSTED if `map` is full, `map` can be
+ *  reinitialized with a bigger buffer and the call repeated.
+ */
+kh_ast_response kh_ast_hash_map_insert_tree(kh_ast_hash_map * map, const kh_ast_tree * tree);
+
+/*
+ *  Looks up a node id by its subtree hash.
+ *  Returns true if found and was placed on `id_out` otherwise false
+ */
+kh_bool kh_ast_hash_map_find(const kh_ast_hash_map * map, kh_u64 hash, kh_ast_node_id * id_out);
+
+/*
+ *  Matches the nodes of a freshly built and hashed `new_tree` against the nodes of `old_tree`
+ *  through `old_map` (filled with `kh_ast_hash_map_insert_tree` on `old_tree`).
+ *  `reuse_out` must hold a node id for every node in `new_tree`, each is set to the id of the
+ *  identical node in `old_tree` or KH_AST_NODE_ID_INVALID if its subtree changed. Descendants
+ *  of a matched subtree are mapped to their counterpart so any result cached on an old node
+ *  can be carried over.
+ *  Returns KH_AST_RESPONSE_ERR if `KH_AST_TRACK_HASH` is not enabled.
+ */
+kh_ast_response kh_ast_tree_reuse(const kh_ast_tree * new_tree, const kh_ast_tree * old_tree, const kh_ast_hash_map * old_map, kh_ast_node_id * reuse_out);
@@ -56,6 +56,39 @@ typedef struct _kh_lexer_token_entry {
 #endif
 } kh_lexer_token_entry;
 
+#if defined(KH_LEXER_STATS)
+#define KH_LEXER_STATS_MAX_LEXERS       8
+#define KH_LEXER_STATS_TOKEN_TYPES      (KH_TOK_F64 + 1)
+#define KH_LEXER_STATS_HISTOGRAM_BUCKETS 16
+
+/*
+ *  Lexer statistics, only available when `KH_LEXER_STATS` is defined.
+ *  Per lexer arrays are indexed in dispatch order (see kh_lexer_stats_lexer_name).
+ *  Histogram bucket 0 counts lengths of 0, bucket n counts lengths in [2^(n-1), 2^n)
+ *  with the last bucket also counting everything above it. Lengths are in bytes.
+ */
+typedef struct _kh_lexer_stats {
+  kh_u64 lexer_attempts[KH_LEXER_STATS_MAX_LEXERS]; // Times a lexer was called
+  kh_u64 lexer_matches[KH_LEXER_STATS_MAX_LEXERS];  // Times a lexer responded with a match
+  kh_u64 lexer_bytes[KH_LEXER_STATS_MAX_LEXERS];    // Source bytes consumed by a lexer's matches
+#if defined(KH_LEXER_STATS_CYCLES)
+  kh_u64 lexer_cycles[KH_LEXER_STATS_MAX_LEXERS];   // Cycle counter ticks spent in a lexer, matched or not
+#endif
+
+  kh_u64 token_bytes[KH_LEXER_STATS_TOKEN_TYPES];   // Source bytes consumed per token type
+
+  kh_u64 acquire_entry_calls;
+  kh_u64 buffer_exhausted; // Times the lexer returned KH_LEXER_RESPONSE_BUFFER_EXHAUSTED
+
+  kh_u32        longest_token;
+  kh_token_type longest_token_type;
+
+  kh_u64 string_lengths[KH_LEXER_STATS_HISTOGRAM_BUCKETS];
+  kh_u64 identifier_lengths[KH_LEXER_STATS_HISTOGRAM_BUCKETS];
+  kh_u64 comment_lengths[KH_LEXER_STATS_HISTOGRAM_BUCKETS];
+} kh_lexer_stats;
+#endif
+
 typedef struct _kh_lexer_context {
   kh_lexer_status status;
 
@@ -71,6 +104,10 @@ typedef struct _kh_lexer_context {
   kh_u32 line;
   kh_u32 column;
 #endif
+
+#if defined(KH_LEXER_STATS)
+  kh_lexer_stats stats; // Accumulated across calls, zero it to reset
+#endif
 } kh_lexer_context;
 
 /*
@@ -128,3 +165,16 @@ kh_utf8 kh_lexer_token_entry_value_charsym_get(const kh_lexer_token_entry * c);
  */
 kh_u32 kh_lexer_token_entry_value_str_index_get(const kh_lexer_token_entry * c); 
 kh_u32 kh_lexer_token_entry_value_str_sz_get(const kh_lexer_token_entry * c);
+
+#if defined(KH_LEXER_STATS)
+/*
+ *  Reports the number of lexers used in `kh_lexer_stats` per lexer arrays
+ */
+kh_u32 kh_lexer_stats_lexer_count();
+
+/*
+ *  Obtains the name of the lexer at `index` in `kh_lexer_stats` per lexer arrays.
+ *  Returns NULL if `index` is out of range
+ */
+const char * kh_lexer_stats_lexer_name(kh_u32 index);
+#endif
@@ -2,19 +2,294 @@
 
 static const kh_u8 INVALID_NODE_OFFSET = KH_U8_INVALID;
 
+// [18/10/2026] FNV-1a, only used to detect changes so it doesn't have to be anything fancy
+static const kh_u64 FNV_OFFSET_BASIS = 0xCBF29CE484222325ull;
+static const kh_u64 FNV_PRIME        = 0x00000100000001B3ull;
+
+static kh_u64 hash_bytes(kh_u64 hash, const void * data, kh_sz size) {
+  const kh_u8 * bytes = (const kh_u8 *)data;
+  for (kh_sz i = 0; i < size; ++i) {
+    hash ^= bytes[i];
+    hash *= FNV_PRIME;
+  }
+  return hash;
+}
+
+#if defined(KH_AST_TRACK_HASH)
+// [18/10/2026] Children always have a higher id than their parent so their hash has to be up to date
+// before this is called. Absent children are mixed in as 0 so a single child hashes differently per side.
+// TODO: mix in the node's payload once nodes carry one
+static kh_u64 node_hash(const kh_ast_tree * tree, kh_ast_node_id id) {
+  const kh_ast_node * node = &tree->root[id];
+
+  const kh_u64 left  = node->left  != INVALID_NODE_OFFSET ? tree->root[id + node->left].hash  : 0;
+  const kh_u64 right = node->right != INVALID_NODE_OFFSET ? tree->root[id + node->right].hash : 0;
+
+  kh_u64 hash = hash_bytes(FNV_OFFSET_BASIS, &node->type, sizeof(node->type));
+  hash = hash_bytes(hash, &left, sizeof(left));
+  hash = hash_bytes(hash, &right, sizeof(right));
+  return hash;
+}
+#endif
+
+
 kh_ast_response kh_ast_init_tree(kh_ast_tree * tree) {
   kh_ast_node * root = &tree->root[0];
 
   root->type  = KH_AST_NODE_ROOT;
   root->left  = INVALID_NODE_OFFSET;
   root->right = INVALID_NODE_OFFSET;
+#if defined(KH_AST_TRACK_HASH)
+  root->hash  = node_hash(tree, 0);
+#endif
+
+  tree->last_node = 0;
+
+  return KH_AST_RESPONSE_OK;
+}
+
+// [18/10/2026] Child offsets are relative to the parent and always forward since nodes are only ever appended
+static kh_ast_response append_child(kh_ast_tree * tree, kh_ast_node_id parent, kh_u8 * slot, kh_ast_node_id * child_id_out) {
+  if (*slot != INVALID_NODE_OFFSET)
+    return KH_AST_RESPONSE_OCCUPIED;
+
+  const kh_sz child = tree->last_node + 1;
+  if ((child + 1) * sizeof(kh_ast_node) > tree->sz)
+    return KH_AST_RESPONSE_BUFFER_EXHAUSTED;
+
+  if (child - parent >= INVALID_NODE_OFFSET) // [18/10/2026] Has to fit a kh_u8 offset
+    return KH_AST_RESPONSE_ERR;
+
+  kh_ast_node * node = &tree->root[child];
+  node->type  = KH_AST_NODE_EMPTY;
+  node->left  = INVALID_NODE_OFFSET;
+  node->right = INVALID_NODE_OFFSET;
+#if defined(KH_AST_TRACK_HASH)
+  node->hash  = node_hash(tree, child);
+#endif
+
+  *slot           = child - parent;
+  tree->last_node = child;
+  *child_id_out   = child;
 
   return KH_AST_RESPONSE_OK;
 }
 
 kh_ast_response kh_ast_append_left(kh_ast_tree * tree, kh_ast_node_id parent, kh_ast_node_id * child_id_out) {
+  if (parent > tree->last_node)
+    return KH_AST_RESPONSE_ERR;
+
+  return append_child(tree, parent, &tree->root[parent].left, child_id_out);
+}
+
+kh_ast_response kh_ast_append_right(kh_ast_tree * tree, kh_ast_node_id parent, kh_ast_node_id * child_id_out) {
+  if (parent > tree->last_node)
+    return KH_AST_RESPONSE_ERR;
+
+  return append_child(tree, parent, &tree->root[parent].right, child_id_out);
+}
+
+// ---------------------------------------------------------------------------------------------------- 
+
+kh_u64 kh_ast_node_hash_get(const kh_ast_tree * tree, kh_ast_node_id id) {
+#if defined(KH_AST_TRACK_HASH)
+  return tree->root[id].hash;
+#else
+  return 0;
+#endif
+}
+
+kh_ast_response kh_ast_node_hash_update(kh_ast_tree * tree, kh_ast_node_id id) {
+#if defined(KH_AST_TRACK_HASH)
+  if (id > tree->last_node)
+    return KH_AST_RESPONSE_ERR;
 
+  tree->root[id].hash = node_hash(tree, id);
+  return KH_AST_RESPONSE_OK;
+#else
+  return KH_AST_RESPONSE_ERR;
+#endif
+}
+
+kh_ast_response kh_ast_tree_hash(kh_ast_tree * tree) {
+#if defined(KH_AST_TRACK_HASH)
+  // [18/10/2026] Walking the ids backwards is a post order pass as children always come after their parent
+  for (kh_sz id = tree->last_node + 1; id-- > 0;)
+    tree->root[id].hash = node_hash(tree, id);
+  return KH_AST_RESPONSE_OK;
+#else
   return KH_AST_RESPONSE_ERR;
+#endif
+}
+
+kh_ast_response kh_ast_hash_map_init(kh_ast_hash_map * map) {
+  if (map->capacity == 0 || (map->capacity & (map->capacity - 1)) != 0)
+    return KH_AST_RESPONSE_ERR;
+
+  for (kh_sz i = 0; i < map->capacity; ++i) {
+    map->entries[i].hash = 0;
+    map->entries[i].id   = KH_AST_NODE_ID_INVALID;
+  }
+  map->count = 0;
+
+  return KH_AST_RESPONSE_OK;
+}
+
+kh_ast_response kh_ast_hash_map_insert_tree(kh_ast_hash_map * map, const kh_ast_tree * tree) {
+#if defined(KH_AST_TRACK_HASH)
+  const kh_sz mask = map->capacity - 1;
+
+  for (kh_sz id = 0; id <= tree->last_node; ++id) {
+    const kh_u64 hash = tree->root[id].hash;
+
+    kh_sz i = hash & mask;
+    while (map->entries[i].id != KH_AST_NODE_ID_INVALID && map->entries[i].hash != hash)
+      i = (i + 1) & mask;
+
+    if (map->entries[i].id != KH_AST_NODE_ID_INVALID) // [18/10/2026] Identical subtree already inserted
+      continue;
+
+    // [18/10/2026] Always keep a free entry so lookups of missing hashes terminate
+    if (map->count + 1 >= map->capacity)
+      return KH_AST_RESPONSE_BUFFER_EXHAUSTED;
+
+    map->entries[i].hash = hash;
+    map->entries[i].id   = id;
+    ++map->count;
+  }
+
+  return KH_AST_RESPONSE_OK;
+#else
+  return KH_AST_RESPONSE_ERR;
+#endif
+}
+
+kh_bool kh_ast_hash_map_find(const kh_ast_hash_map * map, kh_u64 hash, kh_ast_node_id * id_out) {
+  const kh_sz mask = map->capacity - 1;
+
+  kh_sz i = hash & mask;
+  while (map->entries[i].id != KH_AST_NODE_ID_INVALID) {
+    if (map->entries[i].hash == hash) {
+      *id_out = map->entries[i].id;
+      return 1;
+    }
+    i = (i + 1) & mask;
+  }
+
+  return 0;
+}
+
+kh_ast_response kh_ast_tree_reuse(const kh_ast_tree * new_tree, const kh_ast_tree * old_tree, const kh_ast_hash_map * old_map, kh_ast_node_id * reuse_out) {
+#if defined(KH_AST_TRACK_HASH)
+  for (kh_sz id = 0; id <= new_tree->last_node; ++id)
+    reuse_out[id] = KH_AST_NODE_ID_INVALID;
+
+  // [18/10/2026] Parents come before their children so a matched parent has already mapped
+  // its children by the time we reach them and we never look them up individually
+  for (kh_sz id = 0; id <= new_tree->last_node; ++id) {
+    const kh_ast_node * node = &new_tree->root[id];
+
+    kh_ast_node_id old = reuse_out[id];
+    if (old == KH_AST_NODE_ID_INVALID) {
+      if (!kh_ast_hash_map_find(old_map, node->hash, &old) || old > old_tree->last_node || old_tree->root[old].type != node->type)
+        continue;
+      reuse_out[id] = old;
+    }
+
+    const kh_ast_node * old_node = &old_tree->root[old];
+    if (node->left != INVALID_NODE_OFFSET && old_node->left != INVALID_NODE_OFFSET)
+      reuse_out[id + node->left] = old + old_node->left;
+    if (node->right != INVALID_NODE_OFFSET && old_node->right != INVALID_NODE_OFFSET)
+      reuse_out[id + node->right] = old + old_node->right;
+  }
+
+  return KH_AST_RESPONSE_OK;
+#else
+  return KH_AST_RESPONSE_ERR;
+#endif
+}
+
+// ---------------------------------------------------------------------------------------------------- 
+
+static kh_u32 tree_node_count(const kh_ast_tree * tree) {
+  return (kh_u32)tree->last_node + 1;
+}
+
+kh_u64 kh_ast_hash_source(const kh_utf8 * src, kh_sz src_size) {
+  return hash_bytes(FNV_OFFSET_BASIS, src, src_size);
+}
+
+kh_sz kh_ast_snapshot_size(const kh_ast_tree * tree) {
+  return sizeof(kh_ast_snapshot_header) + tree_node_count(tree) * sizeof(kh_ast_node);
+}
+
+kh_ast_response kh_ast_snapshot_save(const kh_ast_tree * tree, kh_u64 src_hash, void * buffer, kh_sz buffer_size) {
+  const kh_u32 node_count = tree_node_count(tree);
+  const kh_sz  nodes_size = node_count * sizeof(kh_ast_node);
+
+  if (nodes_size > tree->sz)
+    return KH_AST_RESPONSE_ERR;
+
+  if (buffer_size < kh_ast_snapshot_size(tree))
+    return KH_AST_RESPONSE_BUFFER_EXHAUSTED;
+
+  kh_ast_snapshot_header * header = (kh_ast_snapshot_header *)buffer;
+  kh_ast_node            * nodes  = (kh_ast_node *)(header + 1);
+
+  for (kh_u32 i = 0; i < node_count; ++i)
+    nodes[i] = tree->root[i];
+
+  header->magic      = KH_AST_SNAPSHOT_MAGIC;
+  header->version    = KH_AST_SNAPSHOT_VERSION;
+  header->node_size  = sizeof(kh_ast_node);
+  header->node_count = node_count;
+  header->src_hash   = src_hash;
+  header->checksum   = hash_bytes(FNV_OFFSET_BASIS, nodes, nodes_size); // [18/10/2026] Hashed from the copy so padding bytes match on load
+
+  return KH_AST_RESPONSE_OK;
+}
+
+kh_ast_response kh_ast_snapshot_load(kh_ast_tree * tree, kh_u64 src_hash, void * buffer, kh_sz buffer_size) {
+  if (buffer_size < sizeof(kh_ast_snapshot_header) || ((kh_sz)buffer % _Alignof(kh_ast_snapshot_header)) != 0)
+    return KH_AST_RESPONSE_SNAPSHOT_INVALID;
+
+  const kh_ast_snapshot_header * header = (const kh_ast_snapshot_header *)buffer;
+  if (header->magic     != KH_AST_SNAPSHOT_MAGIC   ||
+      header->version   != KH_AST_SNAPSHOT_VERSION ||
+      header->node_size != sizeof(kh_ast_node)     ||
+      header->node_count == 0
+  ) {
+    return KH_AST_RESPONSE_SNAPSHOT_INVALID;
+  }
+
+  // [18/10/2026] Checked against the remaining size rather than multiplied out to avoid an overflow from a corrupted count
+  const kh_sz nodes_size = buffer_size - sizeof(kh_ast_snapshot_header);
+  if (header->node_count > nodes_size / sizeof(kh_ast_node))
+    return KH_AST_RESPONSE_SNAPSHOT_INVALID;
+
+  kh_ast_node * nodes = (kh_ast_node *)(header + 1);
+  if (hash_bytes(FNV_OFFSET_BASIS, nodes, header->node_count * sizeof(kh_ast_node)) != header->checksum)
+    return KH_AST_RESPONSE_SNAPSHOT_INVALID;
+
+  if (header->src_hash != src_hash)
+    return KH_AST_RESPONSE_SNAPSHOT_STALE;
+
+  tree->root      = nodes;
+  tree->sz        = header->node_count * sizeof(kh_ast_node);
+  tree->last_node = header->node_count - 1;
+
+  return KH_AST_RESPONSE_OK;
+}
+
+kh_ast_response kh_ast_snapshot_load_or_rebuild(kh_ast_tree * tree, kh_u64 src_hash, void * buffer, kh_sz buffer_size, kh_ast_rebuild_cb_t rebuild, void * user) {
+  kh_ast_response resp = KH_AST_RESPONSE_SNAPSHOT_INVALID;
+  if (buffer)
+    resp = kh_ast_snapshot_load(tree, src_hash, buffer, buffer_size);
+
+  if (resp == KH_AST_RESPONSE_SNAPSHOT_INVALID || resp == KH_AST_RESPONSE_SNAPSHOT_STALE)
+    resp = rebuild(tree, user);
+
+  return resp;
 }
 
 #if 0
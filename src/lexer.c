@@ -47,6 +47,31 @@ static const kh_utf8 tok_stringcont[] = {
   #define KH_HLP_ADD_COLUMN(x)
 #endif
 
+#if defined(KH_LEXER_STATS)
+  #define KH_HLP_STAT_INC(field) ++ctx->stats.field
+#else
+  #define KH_HLP_STAT_INC(field)
+#endif
+
+#if defined(KH_LEXER_STATS) && defined(KH_LEXER_STATS_CYCLES)
+  #if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    #include <intrin.h>
+    #define KH_HLP_CYCLES() __rdtsc()
+  #elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+    #include <x86intrin.h>
+    #define KH_HLP_CYCLES() __rdtsc()
+  #elif (defined(__GNUC__) || defined(__clang__)) && defined(__aarch64__)
+    static kh_u64 read_cycles() {
+      kh_u64 v;
+      __asm__ volatile("mrs %0, cntvct_el0" : "=r"(v));
+      return v;
+    }
+    #define KH_HLP_CYCLES() read_cycles()
+  #else
+    #error "khuneo > astgen > lexer > KH_LEXER_STATS_CYCLES is enabled but no cycle counter is available for this compiler and architecture."
+  #endif
+#endif
+
 static kh_bool is_src_end(kh_lexer_context * ctx, kh_u32 offset) {
   return (ctx->isrc + offset) >= ctx->src_size;
 }
@@ -69,6 +94,8 @@ static kh_bool is_src_end(kh_lexer_context * ctx, kh_u32 offset) {
  *
  */
 static kh_lexer_token_entry * acquire_entry(kh_lexer_context * ctx) {
+  KH_HLP_STAT_INC(acquire_entry_calls);
+
   kh_sz new_index = ctx->itoken_buffer + sizeof(kh_lexer_token_entry);
   if (new_index >= ctx->token_buffer_size) {
     ctx->status = KH_LEXER_STATUS_BUFFER_EXHAUSTED;
@@ -436,6 +463,61 @@ static const lexer_cb_t lexers[] = {
 
 // ---------------------------------------------------------------------------------------------------- 
 
+#if defined(KH_LEXER_STATS)
+static const char * lexer_names[] = {
+  "whitespace",
+  "comments",
+  "charsymbols",
+  "strings",
+  // "keywords",
+  "identifiers",
+  "numbers",
+};
+
+_Static_assert(sizeof(lexer_names) / sizeof(lexer_names[0]) == sizeof(lexers) / sizeof(lexers[0]), "khuneo > astgen > lexer > lexer_names must match lexers");
+_Static_assert(sizeof(lexers) / sizeof(lexers[0]) <= KH_LEXER_STATS_MAX_LEXERS, "khuneo > astgen > lexer > KH_LEXER_STATS_MAX_LEXERS is less than the number of lexers");
+
+static void stats_histogram_add(kh_u64 * histogram, kh_sz len) {
+  kh_u32 bucket = 0;
+  while (len && bucket < KH_LEXER_STATS_HISTOGRAM_BUCKETS - 1) {
+    len >>= 1;
+    ++bucket;
+  }
+  ++histogram[bucket];
+}
+
+// [18/10/2026] Called after a match, `isrc_before` and `itoken_before` are the context's indexes before the lexer was called
+static void stats_record_match(kh_lexer_context * ctx, int ilexer, kh_sz isrc_before, kh_sz itoken_before) {
+  kh_lexer_stats * stats = &ctx->stats;
+  const kh_sz len = ctx->isrc - isrc_before;
+
+  ++stats->lexer_matches[ilexer];
+  stats->lexer_bytes[ilexer] += len;
+
+  if (lexers[ilexer] == lex_comments)
+    stats_histogram_add(stats->comment_lengths, len);
+
+  // [18/10/2026] Not every match produces a token (eg. whitespace and comments)
+  if (ctx->itoken_buffer == itoken_before)
+    return;
+
+  const kh_lexer_token_entry * entry = (const kh_lexer_token_entry *)((const kh_u8 *)ctx->token_buffer + itoken_before);
+  stats->token_bytes[entry->type] += len;
+
+  if (len > stats->longest_token) {
+    stats->longest_token      = (kh_u32)len;
+    stats->longest_token_type = entry->type;
+  }
+
+  if (entry->type == KH_TOK_STRING)
+    stats_histogram_add(stats->string_lengths, len);
+  else if (entry->type == KH_TOK_IDENTIFIER)
+    stats_histogram_add(stats->identifier_lengths, len);
+}
+#endif
+
+// ---------------------------------------------------------------------------------------------------- 
+
 kh_lexer_response kh_lexer(kh_lexer_context * ctx) {
   const int nlexers = sizeof(lexers) / sizeof(void *);
   kh_lex_resp resp = KH_LEX_ABORT;
@@ -443,14 +525,33 @@ kh_lexer_response kh_lexer(kh_lexer_context * ctx) {
   while (!is_src_end(ctx, 0)) {
 
     for (int i = 0; i < nlexers; ++i) {
+#if defined(KH_LEXER_STATS)
+      const kh_sz isrc_before   = ctx->isrc;
+      const kh_sz itoken_before = ctx->itoken_buffer;
+      ++ctx->stats.lexer_attempts[i];
+#if defined(KH_LEXER_STATS_CYCLES)
+      const kh_u64 cycles_start = KH_HLP_CYCLES();
+#endif
+#endif
+
       resp = lexers[i](ctx);
+
+#if defined(KH_LEXER_STATS_CYCLES) && defined(KH_LEXER_STATS)
+      ctx->stats.lexer_cycles[i] += KH_HLP_CYCLES() - cycles_start;
+#endif
+
       if (resp == KH_LEX_PASS) {
         continue;
       } else if (resp == KH_LEX_ABORT) {
-        if (ctx->status == KH_LEXER_STATUS_BUFFER_EXHAUSTED) // [14/04/2023] Respond with a buffer exhaust instead if that's the status so we dont shutdown the lexer
+        if (ctx->status == KH_LEXER_STATUS_BUFFER_EXHAUSTED) { // [14/04/2023] Respond with a buffer exhaust instead if that's the status so we dont shutdown the lexer
+          KH_HLP_STAT_INC(buffer_exhausted);
           return KH_LEXER_RESPONSE_BUFFER_EXHAUSTED;
+        }
         return KH_LEXER_RESPONSE_ERROR; // [10/04/2023] We dont set ctx->status as the lexer callbacks might've set it
       } else if (resp == KH_LEX_MATCH) {
+#if defined(KH_LEXER_STATS)
+        stats_record_match(ctx, i, isrc_before, itoken_before);
+#endif
         break;
       } else {
         // [10/04/2023] TODO: maybe throw an error? this should never be reachable
@@ -530,4 +631,20 @@ kh_u32 kh_lexer_token_entry_value_str_sz_get(const kh_lexer_token_entry * c) {
   return c->value.string.size;
 }
 
+#if defined(KH_LEXER_STATS)
+kh_u32 kh_lexer_stats_lexer_count() {
+  return sizeof(lexers) / sizeof(lexers[0]);
+}
+
+const char * kh_lexer_stats_lexer_name(kh_u32 index) {
+  if (index >= kh_lexer_stats_lexer_count())
+    return 0;
+  return lexer_names[index];
+}
+#endif
+
 #undef KH_HLP_ADD_COLUMN
+#undef KH_HLP_STAT_INC
+#if defined(KH_HLP_CYCLES)
+#undef KH_HLP_CYCLES
+#endif